@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <vector>
+#include <string>
 
 // Use appropriate types for DIGIT and DBDGT based on debug mode
 #ifdef DEBUG
@@ -30,4 +31,15 @@ Number fibonacci(uint64_t index);
 // Returns the result as a Number.
 Number fibonacci2(uint64_t index);
 
+// Structure to hold the leading digits of a Fibonacci number.
+struct LeadingDigits {
+    std::string digits;   // Most significant digit first, without leading zeros.
+    uint64_t bitLength;   // Exact bit length of the Fibonacci number.
+    uint64_t totalDigits; // Number of digits of the Fibonacci number in the chosen base.
+};
+
+// Computes the first numDigits digits (base 16 or 10) of the Fibonacci number at the
+// given index without computing the whole number. The index must be below 2^63.
+LeadingDigits fibonacciLeading(uint64_t index, size_t numDigits, unsigned base);
+
 #endif // FIBONACCI_H
@@ -0,0 +1,424 @@
+#include "fibonacci.h"
+#include <cmath>
+#include <climits>
+#include <limits>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Leading-digits mode: F(n) = round(phi^n / sqrt(5)), so the top digits can be
+// read off a fixed-precision evaluation of phi^n / sqrt(5) without ever holding
+// the whole number. Every rounding step truncates, which gives a simple relative
+// error bound; the digits are only reported when both ends of the error interval
+// agree on them, otherwise the precision is doubled and we try again.
+
+// floor(log10(2) * 2^64), used to estimate the decimal length from the bit length.
+static const uint64_t LOG10_2_FIXED = 0x4d104d427de7fbccULL;
+
+// A binary floating-point number: value = mantissa * 2^exponent.
+// Results of multiplyFloats() have exactly numDigits limbs with the top bit set.
+struct BigFloat {
+    std::vector<DIGIT> mantissa; // Stored in little-endian order.
+    int64_t exponent;
+};
+
+// Multiplies source array by scale and accumulates into accum.
+// The final carry lands in accum[numDigits], which must still be zero.
+static void scaleAccumulateLead(DIGIT *accum,
+                                const DIGIT *sourceArray, DBDGT scale, size_t numDigits) {
+    size_t i;
+    DBDGT carry = 0;
+    for (i = 0; i < numDigits; ++i) {
+        DBDGT sum = ((DBDGT)accum[i]) + ((DBDGT)sourceArray[i]) * scale + carry;
+        accum[i] = (DIGIT)sum;
+        carry = sum >> DIGIT_BIT;
+    }
+    accum[numDigits] += (DIGIT)carry;
+}
+
+// Multiplies arrays a and b into the zeroed buffer accum (numDigitsA + numDigitsB digits).
+static void multiplyDigits(DIGIT *accum,
+                           const DIGIT *a, const DIGIT *b,
+                           size_t numDigitsA, size_t numDigitsB) {
+    size_t i;
+    for (i = 0; i < numDigitsB; ++i) {
+        scaleAccumulateLead(&accum[i], a, b[i], numDigitsA);
+    }
+}
+
+// Adds source into target in place. The sum must fit into target.
+static void addDigits(std::vector<DIGIT> &target, const std::vector<DIGIT> &source) {
+    size_t i;
+    DBDGT carry = 0;
+    for (i = 0; i < target.size(); ++i) {
+        DBDGT sum = ((DBDGT)target[i]) + (i < source.size() ? source[i] : 0) + carry;
+        target[i] = (DIGIT)sum;
+        carry = sum >> DIGIT_BIT;
+    }
+}
+
+// Subtracts source from target in place. Source must not be larger than target.
+static void subtractDigits(std::vector<DIGIT> &target, const std::vector<DIGIT> &source) {
+    size_t i;
+    DIGIT borrow = 0;
+    for (i = 0; i < target.size(); ++i) {
+        DIGIT subtrahend = i < source.size() ? source[i] : 0;
+        DIGIT difference = target[i] - subtrahend - borrow;
+        borrow = (target[i] < subtrahend || (target[i] == subtrahend && borrow)) ? 1 : 0;
+        target[i] = difference;
+    }
+}
+
+// Removes zero digits from the top; zero becomes an empty array.
+static void trimDigits(std::vector<DIGIT> &value) {
+    while (!value.empty() && value.back() == 0) {
+        value.pop_back();
+    }
+}
+
+// Returns the number of significant bits in value.
+static uint64_t bitLengthOf(const std::vector<DIGIT> &value) {
+    size_t top = value.size();
+    while (top > 0 && value[top - 1] == 0) {
+        --top;
+    }
+    if (top == 0) {
+        return 0;
+    }
+    uint64_t bits = (uint64_t)(top - 1) * DIGIT_BIT;
+    DIGIT topDigit = value[top - 1];
+    while (topDigit) {
+        ++bits;
+        topDigit >>= 1;
+    }
+    return bits;
+}
+
+// Returns floor(source / 2^shift).
+static std::vector<DIGIT> shiftRightDigits(const std::vector<DIGIT> &source, uint64_t shift) {
+    uint64_t digitShift = shift / DIGIT_BIT;
+    unsigned bitShift = (unsigned)(shift % DIGIT_BIT);
+    if (digitShift >= source.size()) {
+        return std::vector<DIGIT>();
+    }
+    std::vector<DIGIT> result(source.size() - digitShift);
+    size_t i;
+    for (i = 0; i < result.size(); ++i) {
+        DIGIT low = source[i + digitShift] >> bitShift;
+        DIGIT high = 0;
+        if (bitShift && i + digitShift + 1 < source.size()) {
+            high = source[i + digitShift + 1] << (DIGIT_BIT - bitShift);
+        }
+        result[i] = low | high;
+    }
+    return result;
+}
+
+// Returns source * 2^shift.
+static std::vector<DIGIT> shiftLeftDigits(const std::vector<DIGIT> &source, uint64_t shift) {
+    uint64_t digitShift = shift / DIGIT_BIT;
+    unsigned bitShift = (unsigned)(shift % DIGIT_BIT);
+    std::vector<DIGIT> result(source.size() + digitShift + 1, 0);
+    size_t i;
+    for (i = 0; i < source.size(); ++i) {
+        result[i + digitShift] |= source[i] << bitShift;
+        if (bitShift) {
+            result[i + digitShift + 1] |= source[i] >> (DIGIT_BIT - bitShift);
+        }
+    }
+    return result;
+}
+
+// Returns floor(mantissa * 2^exponent) as an integer.
+static std::vector<DIGIT> floorFloat(const BigFloat &value) {
+    std::vector<DIGIT> result = value.exponent < 0
+        ? shiftRightDigits(value.mantissa, (uint64_t)(-value.exponent))
+        : shiftLeftDigits(value.mantissa, (uint64_t)value.exponent);
+    trimDigits(result);
+    return result;
+}
+
+// Multiplies two normalized floats, truncating the product to numDigits digits.
+// The relative error introduced is below 2^(1 - numDigits * DIGIT_BIT).
+static BigFloat multiplyFloats(const BigFloat &a, const BigFloat &b, size_t numDigits) {
+    const uint64_t mantissaBits = (uint64_t)numDigits * DIGIT_BIT;
+    std::vector<DIGIT> product(2 * numDigits, 0);
+    multiplyDigits(product.data(), a.mantissa.data(), b.mantissa.data(), numDigits, numDigits);
+    // Both factors are in [2^(W-1), 2^W), so the product has 2W or 2W-1 bits.
+    uint64_t shift = (product.back() >> (DIGIT_BIT - 1)) ? mantissaBits : mantissaBits - 1;
+    BigFloat result;
+    result.mantissa = shiftRightDigits(product, shift);
+    result.mantissa.resize(numDigits);
+    result.exponent = a.exponent + b.exponent + (int64_t)shift;
+    return result;
+}
+
+// Raises base to the given power (power >= 1) by square-and-multiply.
+// Each truncation error is amplified at most by the remaining power, so the
+// result is within 2 * power * 2^(1 - W) plus the error of base times power.
+static BigFloat powerFloat(const BigFloat &base, uint64_t power, size_t numDigits) {
+    BigFloat result;
+    BigFloat square = base;
+    bool haveResult = false;
+    while (power) {
+        if (power & 1) {
+            result = haveResult ? multiplyFloats(result, square, numDigits) : square;
+            haveResult = true;
+        }
+        power >>= 1;
+        if (power) {
+            square = multiplyFloats(square, square, numDigits);
+        }
+    }
+    return result;
+}
+
+// Computes floor(2^W / sqrt(5)) (within one unit from below) with W = numDigits * DIGIT_BIT,
+// using Newton's iteration r' = r + r * (1 - 5r^2) / 2. Started below the root, the
+// truncated iterates never overshoot, so 1 - 5r^2 stays non-negative throughout.
+static std::vector<DIGIT> inverseSqrtFive(size_t numDigits) {
+    const uint64_t fractionBits = (uint64_t)numDigits * DIGIT_BIT;
+    uint64_t seed = (uint64_t)(std::ldexp(1.0 / std::sqrt(5.0), 62) * (1.0 - 1e-12));
+    std::vector<DIGIT> seedDigits;
+    while (seed) {
+        seedDigits.push_back((DIGIT)seed);
+        seed >>= DIGIT_BIT / 2;
+        seed >>= DIGIT_BIT / 2;
+    }
+    std::vector<DIGIT> root = shiftLeftDigits(seedDigits, fractionBits - 62);
+    root.resize(numDigits);
+
+    int iteration;
+    for (iteration = 0; iteration < 64; ++iteration) {
+        std::vector<DIGIT> square(2 * numDigits, 0);
+        multiplyDigits(square.data(), root.data(), root.data(), numDigits, numDigits);
+        std::vector<DIGIT> residual(2 * numDigits + 1, 0);
+        scaleAccumulateLead(residual.data(), square.data(), 5, 2 * numDigits);
+        if (residual.back() != 0) {
+            break;
+        }
+        // residual = 2^(2W) - 5r^2, i.e. 1 - 5r^2 with 2W fraction bits.
+        residual.pop_back();
+        std::vector<DIGIT> one(1, 1);
+        size_t i;
+        for (i = 0; i < residual.size(); ++i) {
+            residual[i] = ~residual[i];
+        }
+        addDigits(residual, one);
+        std::vector<DIGIT> product(3 * numDigits, 0);
+        multiplyDigits(product.data(), root.data(), residual.data(), numDigits, 2 * numDigits);
+        std::vector<DIGIT> correction = shiftRightDigits(product, 2 * fractionBits + 1);
+        trimDigits(correction);
+        if (correction.empty()) {
+            break;
+        }
+        addDigits(root, correction);
+    }
+    return root;
+}
+
+// Computes phi^index / sqrt(5) to numDigits digits.
+// The relative error is below (8 * index + 256) * 2^(1 - W).
+static BigFloat phiPowerOverSqrtFive(uint64_t index, size_t numDigits) {
+    const int64_t fractionBits = (int64_t)numDigits * DIGIT_BIT;
+    std::vector<DIGIT> root = inverseSqrtFive(numDigits);
+
+    // 1/sqrt(5) lies in [1/4, 1/2), so one left shift normalizes it.
+    BigFloat inverseRoot;
+    inverseRoot.mantissa = shiftLeftDigits(root, 1);
+    inverseRoot.mantissa.resize(numDigits);
+    inverseRoot.exponent = -fractionBits - 1;
+
+    // phi = (1 + 5/sqrt(5)) / 2 lies in [1, 2), so the numerator 1 + sqrt(5)
+    // has W + 2 bits and two right shifts normalize it.
+    std::vector<DIGIT> numerator(numDigits + 1, 0);
+    scaleAccumulateLead(numerator.data(), root.data(), 5, numDigits);
+    numerator[numDigits] += 1;
+    BigFloat phi;
+    phi.mantissa = shiftRightDigits(numerator, 2);
+    phi.mantissa.resize(numDigits);
+    phi.exponent = 1 - fractionBits;
+
+    return multiplyFloats(inverseRoot, powerFloat(phi, index, numDigits), numDigits);
+}
+
+// Returns the interval end value * (1 -/+ 2^-slackBits), widened by one unit.
+static BigFloat offsetFloat(const BigFloat &value, uint64_t slackBits, bool upper) {
+    std::vector<DIGIT> delta = shiftRightDigits(value.mantissa, slackBits);
+    std::vector<DIGIT> one(1, 1);
+    delta.resize(value.mantissa.size() + 1, 0);
+    addDigits(delta, one);
+    BigFloat result;
+    result.mantissa = value.mantissa;
+    result.mantissa.push_back(0);
+    if (upper) {
+        addDigits(result.mantissa, delta);
+    } else {
+        subtractDigits(result.mantissa, delta);
+    }
+    result.exponent = value.exponent;
+    return result;
+}
+
+// Returns the bit length of floor(value) for a float with non-negative bit length.
+static uint64_t floatBitLength(const BigFloat &value) {
+    return (uint64_t)((int64_t)bitLengthOf(value.mantissa) + value.exponent);
+}
+
+// Formats an integer in hexadecimal without leading zeros.
+static std::string toHexString(const std::vector<DIGIT> &value) {
+    static const char HEX_CHARS[] = "0123456789abcdef";
+    std::string text;
+    size_t i;
+    for (i = value.size(); i > 0; --i) {
+        int shift;
+        for (shift = DIGIT_BIT - 4; shift >= 0; shift -= 4) {
+            unsigned nibble = (unsigned)((value[i - 1] >> shift) & 0xF);
+            if (text.empty() && nibble == 0) {
+                continue;
+            }
+            text.push_back(HEX_CHARS[nibble]);
+        }
+    }
+    return text.empty() ? std::string("0") : text;
+}
+
+// Formats an integer in decimal without leading zeros.
+// Works in chunks of the largest power of ten that fits into a DIGIT.
+static std::string toDecimalString(std::vector<DIGIT> value) {
+    DIGIT chunk = 1;
+    int chunkDigits = 0;
+    while (chunk <= std::numeric_limits<DIGIT>::max() / 10) {
+        chunk *= 10;
+        ++chunkDigits;
+    }
+    std::string reversed;
+    trimDigits(value);
+    while (!value.empty()) {
+        DBDGT remainder = 0;
+        size_t i;
+        for (i = value.size(); i > 0; --i) {
+            DBDGT current = (remainder << DIGIT_BIT) | value[i - 1];
+            value[i - 1] = (DIGIT)(current / chunk);
+            remainder = current % chunk;
+        }
+        trimDigits(value);
+        int k;
+        for (k = 0; k < chunkDigits; ++k) {
+            reversed.push_back((char)('0' + (int)(remainder % 10)));
+            remainder /= 10;
+        }
+    }
+    while (!reversed.empty() && reversed.back() == '0') {
+        reversed.pop_back();
+    }
+    std::reverse(reversed.begin(), reversed.end());
+    return reversed.empty() ? std::string("0") : reversed;
+}
+
+// Small indices: compute the whole number and cut its representation.
+static LeadingDigits leadingFromExact(uint64_t index, size_t numDigits, unsigned base) {
+    Number exact = fibonacci(index);
+    trimDigits(exact.digits);
+    std::string text = base == 16 ? toHexString(exact.digits) : toDecimalString(exact.digits);
+    LeadingDigits result;
+    result.bitLength = bitLengthOf(exact.digits);
+    result.totalDigits = text.size();
+    result.digits = text.substr(0, numDigits);
+    return result;
+}
+
+// Tries to determine the leading digits at the given precision.
+// Returns false if the error interval is too wide to decide them.
+static bool leadingFromFloat(uint64_t index, size_t numDigits, unsigned base,
+                             size_t precisionDigits, LeadingDigits &result) {
+    const uint64_t mantissaBits = (uint64_t)precisionDigits * DIGIT_BIT;
+    // Guard bits cover the error bounds above with a margin: the index
+    // (or decimal scale) contributes its bit length, the rest is constant.
+    uint64_t guardBits = 12;
+    uint64_t remaining = index;
+    while (remaining) {
+        ++guardBits;
+        remaining >>= 1;
+    }
+    const uint64_t slackBits = mantissaBits - guardBits;
+
+    BigFloat value = phiPowerOverSqrtFive(index, precisionDigits);
+    uint64_t bitLength = floatBitLength(offsetFloat(value, slackBits, false));
+    if (bitLength != floatBitLength(offsetFloat(value, slackBits, true))) {
+        return false;
+    }
+
+    if (base == 16) {
+        uint64_t totalDigits = (bitLength + 3) / 4;
+        BigFloat scaled = value;
+        scaled.exponent -= (int64_t)(4 * (totalDigits - numDigits));
+        std::string lower = toHexString(floorFloat(offsetFloat(scaled, slackBits, false)));
+        std::string upper = toHexString(floorFloat(offsetFloat(scaled, slackBits, true)));
+        if (lower != upper || lower.size() != numDigits) {
+            return false;
+        }
+        result.digits = lower;
+        result.bitLength = bitLength;
+        result.totalDigits = totalDigits;
+        return true;
+    }
+
+    // Decimal: scale by 10^-k, where 0.1 = 0.8 * 2^-3 and 0.8 = 0.1100 1100... in binary.
+    BigFloat tenth;
+    tenth.mantissa.assign(precisionDigits, (DIGIT)0xccccccccccccccccULL);
+    tenth.exponent = -(int64_t)mantissaBits - 3;
+    // The estimate is at most one short of the decimal length; the loop corrects it.
+    uint64_t estimatedDigits = (uint64_t)((((unsigned __int128)(bitLength - 1)) * LOG10_2_FIXED) >> 64) + 1;
+    int64_t scalePower = (int64_t)estimatedDigits - (int64_t)numDigits;
+    BigFloat scaled;
+    int attempt;
+    for (attempt = 0; attempt < 4; ++attempt) {
+        scaled = scalePower > 0
+            ? multiplyFloats(value, powerFloat(tenth, (uint64_t)scalePower, precisionDigits), precisionDigits)
+            : value;
+        std::vector<DIGIT> integerPart = floorFloat(scaled);
+        size_t length = integerPart.empty() ? 0 : toDecimalString(integerPart).size();
+        if (length == numDigits || scalePower <= 0) {
+            break;
+        }
+        scalePower += (int64_t)length - (int64_t)numDigits;
+    }
+    if (scalePower <= 0) {
+        return false;
+    }
+    std::string lower = toDecimalString(floorFloat(offsetFloat(scaled, slackBits, false)));
+    std::string upper = toDecimalString(floorFloat(offsetFloat(scaled, slackBits, true)));
+    if (lower != upper || lower.size() != numDigits) {
+        return false;
+    }
+    result.digits = lower;
+    result.bitLength = bitLength;
+    result.totalDigits = (uint64_t)scalePower + numDigits;
+    return true;
+}
+
+// Computes the leading digits of the Fibonacci number at fibIndex.
+// F(n) has about n * log2(phi) bits; while that is well above the working
+// precision the psi^n / sqrt(5) term is far below the error bound, otherwise
+// the full number is cheap enough to compute exactly.
+LeadingDigits fibonacciLeading(uint64_t fibIndex, size_t numDigits, unsigned base) {
+    if (numDigits == 0) {
+        numDigits = 1;
+    }
+    const double LOG2_PHI = 0.69424191363061737991;
+    const double estimatedBits = (double)fibIndex * LOG2_PHI;
+    const double bitsPerDigit = base == 16 ? 4.0 : 3.3219280948873623479;
+    uint64_t guardBits = 80;
+    size_t precisionDigits =
+        (size_t)(((double)numDigits * bitsPerDigit + guardBits) / DIGIT_BIT) + 2;
+
+    LeadingDigits result;
+    while ((double)precisionDigits * DIGIT_BIT + 2 * DIGIT_BIT < estimatedBits) {
+        if (leadingFromFloat(fibIndex, numDigits, base, precisionDigits, result)) {
+            return result;
+        }
+        precisionDigits *= 2;
+    }
+    return leadingFromExact(fibIndex, numDigits, base);
+}
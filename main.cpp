@@ -11,11 +11,12 @@
 //   check_endianness : Check system endianness.
 //   hex              : Use the first Fibonacci implementation.
 //   hex2             : Use the alternate Fibonacci implementation.
+//   lead             : Print only the leading digits and the bit length.
 //   eval             : Run evaluation mode.
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cerr << "Usage: " << argv[0]
-                  << " {check_endianness|hex|hex2|eval} ..." << std::endl;
+                  << " {check_endianness|hex|hex2|lead|eval} ..." << std::endl;
         return EXIT_FAILURE;
     }
     
@@ -75,6 +76,41 @@ int main(int argc, char* argv[]) {
         } else {
             printNumberInHex(resultNumber, std::cout);
         }
+    } else if (std::strcmp(argv[1], "lead") == 0) {
+        if (argc < 3 || argc > 5) {
+            std::cerr << "Usage: " << argv[0]
+                      << " lead index [digits] [hex|dec]" << std::endl;
+            return EXIT_FAILURE;
+        }
+        char* endPtr = 0;
+        uint64_t fibIndex = std::strtoull(argv[2], &endPtr, 10);
+        if (*endPtr != '\0' || (fibIndex >> 63) != 0) {
+            std::cerr << "Invalid index: " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        size_t numDigits = 64;
+        if (argc >= 4) {
+            numDigits = std::strtoull(argv[3], &endPtr, 10);
+            if (*endPtr != '\0' || numDigits == 0) {
+                std::cerr << "Invalid digit count: " << argv[3] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        unsigned base = 16;
+        if (argc == 5) {
+            if (std::strcmp(argv[4], "dec") == 0) {
+                base = 10;
+            } else if (std::strcmp(argv[4], "hex") != 0) {
+                std::cerr << "Invalid base: " << argv[4] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        LeadingDigits leading = fibonacciLeading(fibIndex, numDigits, base);
+        std::cerr << "# Fibonacci index (lead): " << fibIndex << std::endl;
+        std::cerr << "# Bit length: " << leading.bitLength << std::endl;
+        std::cerr << "# Total " << (base == 16 ? "hex" : "decimal") << " digits: "
+                  << leading.totalDigits << std::endl;
+        std::cout << leading.digits << std::endl;
     } else if (std::strcmp(argv[1], "eval") == 0) {
         runEvaluation();
     } else {